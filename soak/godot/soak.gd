@@ -0,0 +1,143 @@
+# Headless soak test for the wrapper: SkaldEngine, response conversion and
+# the text cache, over the same corpus as soak/skald_soak.cpp. Samples RSS,
+# static memory and the live object count, and exits 1 if any of them grows
+# past its limit after warm-up.
+#
+#     godot --headless --path soak/godot --import
+#     godot --headless --path soak/godot --script res://soak.gd -- --steps=2000000
+extends SceneTree
+
+var steps := 2000000
+var reloads := 5000
+var sample_every := 100000
+var warmup := 0.1
+var max_rss_growth_kb := 8192
+var max_static_growth_kb := 4096
+var max_object_growth := 100
+
+var engine: SkaldEngine
+var modules: PackedStringArray = []
+var next_module := 0
+var load_count := 0
+var runtime_errors := 0
+
+
+func _initialize() -> void:
+	for arg in OS.get_cmdline_user_args():
+		var parts := arg.trim_prefix("--").split("=")
+		if parts.size() == 2 and parts[0].replace("-", "_") in self:
+			set(parts[0].replace("-", "_"), str_to_var(parts[1]))
+
+	engine = SkaldEngine.new()
+
+	for file in DirAccess.get_files_at("res://corpus"):
+		if file.get_extension() == "ska":
+			modules.append("res://corpus/" + file)
+	modules.sort()
+	if modules.is_empty():
+		printerr("soak: no .ska modules in res://corpus")
+		quit(2)
+		return
+	if not check(engine.setup("res://corpus/soak.codex"), "res://corpus/soak.codex"):
+		quit(2)
+		return
+
+	quit(run())
+
+
+func run() -> int:
+	var warmup_steps := int(steps * warmup)
+	var reload_every := maxi(steps / reloads, 1) if reloads > 0 else 0
+	var base := {}
+	var sample := {}
+
+	print("step,reloads,rss_kb,static_kb,objects")
+	var response = enter_next()
+	for step in range(1, steps + 1):
+		if response == null:
+			break
+		if reload_every > 0 and step % reload_every == 0:
+			response = enter_next()
+		else:
+			response = advance(response)
+
+		if step % sample_every == 0 or step == steps:
+			sample = {
+				"rss": read_rss_kb(),
+				"static": int(Performance.get_monitor(Performance.MEMORY_STATIC)) / 1024,
+				"objects": int(Performance.get_monitor(Performance.OBJECT_COUNT)),
+			}
+			print("%d,%d,%d,%d,%d" % [step, load_count, sample.rss, sample.static, sample.objects])
+			if base.is_empty() and step >= warmup_steps:
+				base = sample
+	engine.free()
+
+	if response == null or base.is_empty():
+		return 2
+	var failed := false
+	print("soak: %d steps, %d loads, %d runtime errors" % [steps, load_count, runtime_errors])
+	for key in [["rss", max_rss_growth_kb], ["static", max_static_growth_kb], ["objects", max_object_growth]]:
+		var growth: int = sample[key[0]] - base[key[0]]
+		print("soak: %s %+d (limit %d) since warm-up" % [key[0], growth, key[1]])
+		if growth > key[1]:
+			printerr("soak: FAIL: %s grew past the threshold" % key[0])
+			failed = true
+	if load_count < reloads:
+		printerr("soak: FAIL: only %d of %d loads ran" % [load_count, reloads])
+		failed = true
+	return 1 if failed else 0
+
+
+# A module that doesn't parse is a broken corpus, not a leak; returns null so
+# run() stops with exit code 2.
+func enter(path: String, tag := ""):
+	if not check(engine.load(path), path):
+		return null
+	load_count += 1
+	return engine.start() if tag.is_empty() else engine.start_at(tag)
+
+
+func enter_next():
+	var path := modules[next_module]
+	next_module = (next_module + 1) % modules.size()
+	return enter(path)
+
+
+func advance(response):
+	if response is SkaldContent or response is SkaldAction or response is SkaldNotification:
+		return engine.advance()
+	if response is SkaldOptionGroup:
+		var available := []
+		for i in response.count:
+			if response.options[i].is_available:
+				available.append(i)
+		return enter_next() if available.is_empty() else engine.act(available.pick_random())
+	if response is SkaldQuery:
+		return engine.answer(randi_range(1, 20))
+	if response is SkaldGoModule:
+		return enter("res://corpus/" + response.module_path.get_file(), response.start_tag)
+	if response is SkaldError:
+		runtime_errors += 1
+		if runtime_errors <= 10:
+			printerr("soak: runtime error %d at line %d: %s" % [response.code, response.line_number, response.message])
+	# Exit, end and errors start the next module.
+	return enter_next()
+
+
+func check(result, path: String) -> bool:
+	if result.ok:
+		return true
+	printerr("soak: %s failed to parse" % path)
+	for err in result.errors:
+		printerr("  %s:%d:%d: %s" % [err.source, err.line, err.column, err.message])
+	return false
+
+
+# Linux only (assumes 4 KiB pages); -1 elsewhere, which never trips the
+# threshold.
+func read_rss_kb() -> int:
+	var statm := FileAccess.open("/proc/self/statm", FileAccess.READ)
+	if statm == null:
+		return -1
+	var fields := statm.get_line().split(" ")
+	return fields[1].to_int() * 4096 / 1024 if fields.size() > 1 else -1
@@ -0,0 +1,308 @@
+// Headless soak test for the Skald core.
+//
+// Drives a Skald::Engine through millions of steps and thousands of module
+// loads over the corpus in soak/corpus, sampling RSS and live heap
+// allocations as it goes. After a warm-up period the first sample becomes the
+// baseline; the run fails if either figure grows past its threshold by the
+// end. Built from the core sources alone (no Godot), so it runs on a plain
+// Linux box:
+//
+//     scons soak-run
+//     soak/bin/skald_soak --steps 10000000 --reloads 20000
+//
+// The wrapper's conversion layer needs the Godot runtime; soak/godot/soak.gd
+// covers it headlessly.
+
+#include <skald.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <variant>
+#include <vector>
+
+// --- Allocation counting ---
+
+// Every global operator new/delete in the process goes through these, the
+// statically linked core included.
+static std::atomic<int64_t> live_allocations{ 0 };
+static std::atomic<uint64_t> total_allocations{ 0 };
+
+void *operator new(size_t p_size) {
+	void *ptr = std::malloc(p_size ? p_size : 1);
+	if (!ptr) {
+		throw std::bad_alloc();
+	}
+	live_allocations.fetch_add(1, std::memory_order_relaxed);
+	total_allocations.fetch_add(1, std::memory_order_relaxed);
+	return ptr;
+}
+
+void operator delete(void *p_ptr) noexcept {
+	if (p_ptr) {
+		live_allocations.fetch_sub(1, std::memory_order_relaxed);
+		std::free(p_ptr);
+	}
+}
+
+void operator delete(void *p_ptr, size_t) noexcept {
+	operator delete(p_ptr);
+}
+
+static int64_t read_rss_kb() {
+	std::ifstream statm("/proc/self/statm");
+	long pages = 0;
+	long resident = 0;
+	if (!(statm >> pages >> resident)) {
+		return -1;
+	}
+	return (int64_t)resident * sysconf(_SC_PAGESIZE) / 1024;
+}
+
+// --- Options ---
+
+struct SoakOptions {
+	std::string corpus = "soak/corpus";
+	int64_t steps = 2000000;
+	int64_t reloads = 5000;
+	int64_t sample_every = 100000;
+	// Share of the steps run before the baseline sample is taken.
+	double warmup = 0.1;
+	int64_t max_rss_growth_kb = 4096;
+	int64_t max_allocation_growth = 1000;
+	uint32_t seed = 1;
+};
+
+static void print_usage() {
+	std::printf(
+			"usage: skald_soak [--corpus DIR] [--steps N] [--reloads N] [--sample-every N]\n"
+			"                  [--warmup FRACTION] [--max-rss-growth-kb N]\n"
+			"                  [--max-allocation-growth N] [--seed N]\n");
+}
+
+static bool parse_options(int p_argc, char **p_argv, SoakOptions &r_options) {
+	for (int i = 1; i < p_argc; i++) {
+		std::string arg = p_argv[i];
+		if (arg == "--help" || i + 1 >= p_argc) {
+			return false;
+		}
+		std::string value = p_argv[++i];
+		if (arg == "--corpus") {
+			r_options.corpus = value;
+		} else if (arg == "--steps") {
+			r_options.steps = std::stoll(value);
+		} else if (arg == "--reloads") {
+			r_options.reloads = std::stoll(value);
+		} else if (arg == "--sample-every") {
+			r_options.sample_every = std::stoll(value);
+		} else if (arg == "--warmup") {
+			r_options.warmup = std::stod(value);
+		} else if (arg == "--max-rss-growth-kb") {
+			r_options.max_rss_growth_kb = std::stoll(value);
+		} else if (arg == "--max-allocation-growth") {
+			r_options.max_allocation_growth = std::stoll(value);
+		} else if (arg == "--seed") {
+			r_options.seed = (uint32_t)std::stoul(value);
+		} else {
+			return false;
+		}
+	}
+	return r_options.steps > 0 && r_options.sample_every > 0;
+}
+
+// --- Driver ---
+
+class SoakDriver {
+	const SoakOptions &options_;
+	Skald::Engine engine_;
+	std::vector<std::string> modules_;
+	size_t next_module_ = 0;
+	std::mt19937 rng_;
+
+	int64_t steps_ = 0;
+	int64_t reloads_ = 0;
+	int64_t runtime_errors_ = 0;
+
+	static std::optional<std::string> read_file(const std::filesystem::path &p_path) {
+		std::ifstream file(p_path, std::ios::binary);
+		if (!file) {
+			return std::nullopt;
+		}
+		std::ostringstream text;
+		text << file.rdbuf();
+		return text.str();
+	}
+
+	static void print_parse_errors(const std::string &p_path, const Skald::ParseResult &p_result) {
+		std::fprintf(stderr, "soak: %s failed to parse\n", p_path.c_str());
+		for (const auto &ex : p_result.exceptions) {
+			std::fprintf(stderr, "  %s:%d:%d: %s\n", ex.pos.source.c_str(), (int)ex.pos.line,
+					(int)ex.pos.column, ex.msg.c_str());
+		}
+	}
+
+	// Loads p_path and enters it at p_tag (or its first block). A corpus that
+	// doesn't parse is a broken harness, not a leak, so it aborts the run.
+	Skald::Response enter(const std::string &p_path, const std::string &p_tag = "") {
+		Skald::ParseResult result = engine_.load(p_path);
+		if (!result.ok) {
+			print_parse_errors(p_path, result);
+			std::exit(2);
+		}
+		reloads_++;
+		return p_tag.empty() ? engine_.start() : engine_.start_at(p_tag);
+	}
+
+	Skald::Response enter_next() {
+		const std::string &path = modules_[next_module_];
+		next_module_ = (next_module_ + 1) % modules_.size();
+		return enter(path);
+	}
+
+	Skald::Response step(const Skald::Response &p_response) {
+		if (std::holds_alternative<Skald::Content>(p_response) ||
+				std::holds_alternative<Skald::MethodCallPost>(p_response) ||
+				std::holds_alternative<Skald::Notification>(p_response)) {
+			return engine_.act(0);
+		}
+		if (auto *group = std::get_if<Skald::OptionGroup>(&p_response)) {
+			std::vector<int> available;
+			for (int i = 0; i < (int)group->options.size(); i++) {
+				if (group->options[i].is_available) {
+					available.push_back(i);
+				}
+			}
+			if (available.empty()) {
+				return enter_next();
+			}
+			return engine_.act(available[rng_() % available.size()]);
+		}
+		if (std::holds_alternative<Skald::MethodCallGet>(p_response)) {
+			return engine_.answer(Skald::QueryAnswer{ Skald::SimpleRValue{ (int)(rng_() % 20) + 1 } });
+		}
+		if (auto *go = std::get_if<Skald::GoModule>(&p_response)) {
+			return enter(go->module_path, go->start_in_tag);
+		}
+		if (auto *error = std::get_if<Skald::Error>(&p_response)) {
+			if (runtime_errors_++ < 10) {
+				std::fprintf(stderr, "soak: runtime error %d at line %d: %s\n", (int)error->code,
+						(int)error->line_number, error->message.c_str());
+			}
+		}
+		// Exit, end and errors start the next module.
+		return enter_next();
+	}
+
+public:
+	explicit SoakDriver(const SoakOptions &p_options) :
+			options_(p_options), rng_(p_options.seed) {}
+
+	bool prepare() {
+		std::filesystem::path corpus(options_.corpus);
+		engine_.set_source_reader(
+				[corpus](const std::string &resolved) -> std::optional<std::string> {
+					std::optional<std::string> source = read_file(resolved);
+					return source ? source : read_file(corpus / resolved);
+				});
+
+		std::error_code ec;
+		for (const auto &entry : std::filesystem::directory_iterator(corpus, ec)) {
+			if (entry.path().extension() == ".ska") {
+				modules_.push_back(entry.path().string());
+			}
+		}
+		if (ec || modules_.empty()) {
+			std::fprintf(stderr, "soak: no .ska modules in %s\n", options_.corpus.c_str());
+			return false;
+		}
+		std::sort(modules_.begin(), modules_.end());
+
+		std::filesystem::path codex = corpus / "soak.codex";
+		if (std::filesystem::exists(codex)) {
+			Skald::ParseResult result = engine_.setup(codex.string());
+			if (!result.ok) {
+				print_parse_errors(codex.string(), result);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	int run() {
+		const int64_t warmup_steps = (int64_t)(options_.steps * options_.warmup);
+		// Reloads forced on top of the ones GO, exit and end cause, so the
+		// requested count is reached whatever paths the corpus takes.
+		const int64_t reload_every = options_.reloads > 0 ? std::max<int64_t>(options_.steps / options_.reloads, 1) : 0;
+
+		int64_t base_rss = -1;
+		int64_t base_allocations = 0;
+		int64_t rss = 0;
+		int64_t allocations = 0;
+
+		std::printf("step,reloads,rss_kb,live_allocations,total_allocations\n");
+		Skald::Response response = enter_next();
+		for (steps_ = 1; steps_ <= options_.steps; steps_++) {
+			response = reload_every > 0 && steps_ % reload_every == 0 ? enter_next() : step(response);
+
+			if (steps_ % options_.sample_every == 0 || steps_ == options_.steps) {
+				rss = read_rss_kb();
+				allocations = live_allocations.load(std::memory_order_relaxed);
+				std::printf("%lld,%lld,%lld,%lld,%llu\n", (long long)steps_, (long long)reloads_,
+						(long long)rss, (long long)allocations,
+						(unsigned long long)total_allocations.load(std::memory_order_relaxed));
+				std::fflush(stdout);
+				if (base_rss < 0 && steps_ >= warmup_steps) {
+					base_rss = rss;
+					base_allocations = allocations;
+				}
+			}
+		}
+
+		int64_t rss_growth = rss - base_rss;
+		int64_t allocation_growth = allocations - base_allocations;
+		std::printf("soak: %lld steps, %lld loads, %lld runtime errors\n", (long long)options_.steps,
+				(long long)reloads_, (long long)runtime_errors_);
+		std::printf("soak: rss %+lld KiB (limit %lld), live allocations %+lld (limit %lld) since warm-up\n",
+				(long long)rss_growth, (long long)options_.max_rss_growth_kb,
+				(long long)allocation_growth, (long long)options_.max_allocation_growth);
+
+		bool failed = false;
+		if (rss_growth > options_.max_rss_growth_kb) {
+			std::fprintf(stderr, "soak: FAIL: RSS grew past the threshold\n");
+			failed = true;
+		}
+		if (allocation_growth > options_.max_allocation_growth) {
+			std::fprintf(stderr, "soak: FAIL: live allocations grew past the threshold\n");
+			failed = true;
+		}
+		if (reloads_ < options_.reloads) {
+			std::fprintf(stderr, "soak: FAIL: only %lld of %lld loads ran\n", (long long)reloads_,
+					(long long)options_.reloads);
+			failed = true;
+		}
+		return failed ? 1 : 0;
+	}
+};
+
+int main(int p_argc, char **p_argv) {
+	SoakOptions options;
+	if (!parse_options(p_argc, p_argv, options)) {
+		print_usage();
+		return 2;
+	}
+	SoakDriver driver(options);
+	if (!driver.prepare()) {
+		return 2;
+	}
+	return driver.run();
+}
@@ -1,4 +1,5 @@
 #include "register_types.h"
+#include "skald_context.h"
 #include "skald_engine.h"
 #include "skald_responses.h"
 
@@ -14,6 +15,7 @@ void initialize_skald_module(ModuleInitializationLevel p_level) {
 	}
 
 	ClassDB::register_class<SkaldEngine>();
+	ClassDB::register_class<SkaldContext>();
 	ClassDB::register_class<SkaldOption>();
 	ClassDB::register_class<SkaldContent>();
 	ClassDB::register_class<SkaldOptionGroup>();
@@ -0,0 +1,256 @@
+#include "skald_context.h"
+#include "skald_convert.h"
+#include "skald_spsc_queue.h"
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <skald.h>
+
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+
+using namespace godot;
+
+// --- Queues ---
+
+enum class SkaldCommandType {
+	SETUP,
+	LOAD,
+	START,
+	START_AT,
+	ACT,
+	ANSWER,
+	SET_GLOBAL,
+};
+
+struct SkaldCommand {
+	SkaldCommandType type = SkaldCommandType::START;
+	// Path, tag or global key, depending on type.
+	std::string text;
+	// Codex / module source for SETUP and LOAD, read on the posting thread.
+	std::optional<std::string> source;
+	int index = 0;
+	std::optional<Skald::SimpleRValue> value;
+};
+
+// A value post_set_global() couldn't convert. It is reported through the
+// result queue so it stays in order with the results around it.
+struct SkaldTypeMismatch {};
+
+// Raw core results; converted to Godot objects by poll() on the posting thread.
+using SkaldResult = std::variant<Skald::Response, Skald::ParseResult, Skald::Error, SkaldTypeMismatch>;
+
+static const size_t CONTEXT_QUEUE_CAPACITY = 256;
+
+struct SkaldContextQueues {
+	SkaldSpscQueue<SkaldCommand, CONTEXT_QUEUE_CAPACITY> commands;
+	SkaldSpscQueue<SkaldResult, CONTEXT_QUEUE_CAPACITY> results;
+	// Path and source of the command being run; the source is handed to the
+	// engine's reader once, and only for exactly that path.
+	std::string pending_path;
+	std::optional<std::string> pending_source;
+};
+
+static std::optional<std::string> read_source_file(const String &p_path) {
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ);
+	if (f.is_null()) {
+		return std::nullopt;
+	}
+	return std::string(f->get_as_text().utf8().get_data());
+}
+
+// --- SkaldContext ---
+
+SkaldContext::SkaldContext() :
+		engine_(std::make_unique<Skald::Engine>()),
+		queues_(std::make_unique<SkaldContextQueues>()) {
+	// Sources are read with FileAccess when a command is posted and travel
+	// with it, so the worker thread never touches Godot's file system. Any
+	// read the posted file can't satisfy (the core resolving the path to
+	// something else, or a second file in one command) fails loudly rather
+	// than being served the wrong text.
+	SkaldContextQueues *queues = queues_.get();
+	engine_->set_source_reader(
+			[queues](const std::string &resolved) -> std::optional<std::string> {
+				if (!queues->pending_source.has_value()) {
+					UtilityFunctions::push_error(vformat(
+							"SkaldContext: \"%s\" was not posted with this command; only the posted file can be read.",
+							String(resolved.c_str())));
+					return std::nullopt;
+				}
+				if (resolved != queues->pending_path) {
+					UtilityFunctions::push_error(vformat(
+							"SkaldContext: core asked for \"%s\" but \"%s\" was posted; pass full res:// paths.",
+							String(resolved.c_str()), String(queues->pending_path.c_str())));
+					queues->pending_source.reset();
+					return std::nullopt;
+				}
+				std::optional<std::string> source = std::move(queues->pending_source);
+				queues->pending_source.reset();
+				return source;
+			});
+}
+SkaldContext::~SkaldContext() = default;
+
+void SkaldContext::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("post_setup", "path"), &SkaldContext::post_setup);
+	ClassDB::bind_method(D_METHOD("post_load", "path"), &SkaldContext::post_load);
+	ClassDB::bind_method(D_METHOD("post_start"), &SkaldContext::post_start);
+	ClassDB::bind_method(D_METHOD("post_start_at", "tag"), &SkaldContext::post_start_at);
+	ClassDB::bind_method(D_METHOD("post_act", "choice_index"), &SkaldContext::post_act, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("post_answer", "value"), &SkaldContext::post_answer);
+	ClassDB::bind_method(D_METHOD("post_set_global", "key", "value"), &SkaldContext::post_set_global);
+	ClassDB::bind_method(D_METHOD("poll"), &SkaldContext::poll);
+	ClassDB::bind_method(D_METHOD("get_pending_commands"), &SkaldContext::get_pending_commands);
+	ClassDB::bind_method(D_METHOD("get_pending_results"), &SkaldContext::get_pending_results);
+	ClassDB::bind_method(D_METHOD("process", "max_commands"), &SkaldContext::process, DEFVAL(0));
+}
+
+bool SkaldContext::post_setup(const String &p_path) {
+	SkaldCommand command;
+	command.type = SkaldCommandType::SETUP;
+	command.text = p_path.utf8().get_data();
+	command.source = read_source_file(p_path);
+	return queues_->commands.push(std::move(command));
+}
+
+bool SkaldContext::post_load(const String &p_path) {
+	SkaldCommand command;
+	command.type = SkaldCommandType::LOAD;
+	command.text = p_path.utf8().get_data();
+	command.source = read_source_file(p_path);
+	return queues_->commands.push(std::move(command));
+}
+
+bool SkaldContext::post_start() {
+	SkaldCommand command;
+	command.type = SkaldCommandType::START;
+	return queues_->commands.push(std::move(command));
+}
+
+bool SkaldContext::post_start_at(const String &p_tag) {
+	SkaldCommand command;
+	command.type = SkaldCommandType::START_AT;
+	command.text = p_tag.utf8().get_data();
+	return queues_->commands.push(std::move(command));
+}
+
+bool SkaldContext::post_act(int p_choice_index) {
+	SkaldCommand command;
+	command.type = SkaldCommandType::ACT;
+	command.index = p_choice_index;
+	return queues_->commands.push(std::move(command));
+}
+
+bool SkaldContext::post_answer(const Variant &p_value) {
+	SkaldCommand command;
+	command.type = SkaldCommandType::ANSWER;
+	command.value = variant_to_simple_rvalue(p_value);
+	return queues_->commands.push(std::move(command));
+}
+
+bool SkaldContext::post_set_global(const String &p_key, const Variant &p_value) {
+	// An unsupported value is still queued, with no value, so the worker can
+	// answer it with a SkaldError; false only ever means the queue is full.
+	SkaldCommand command;
+	command.type = SkaldCommandType::SET_GLOBAL;
+	command.text = p_key.utf8().get_data();
+	command.value = variant_to_simple_rvalue(p_value);
+	return queues_->commands.push(std::move(command));
+}
+
+Variant SkaldContext::poll() {
+	std::optional<SkaldResult> result = queues_->results.pop();
+	if (!result.has_value()) {
+		return Variant();
+	}
+	return std::visit([](auto &&arg) -> Variant {
+		using T = std::decay_t<decltype(arg)>;
+
+		if constexpr (std::is_same_v<T, Skald::Response>) {
+			return convert_response(arg);
+		} else if constexpr (std::is_same_v<T, Skald::ParseResult>) {
+			return make_parse_result(arg);
+		} else if constexpr (std::is_same_v<T, SkaldTypeMismatch>) {
+			return make_error(Skald::ERROR_TYPE_MISMATCH,
+					"set_global only accepts bool, int, float, or String values.", 0);
+		} else {
+			return make_error((int)arg.code, String(arg.message.c_str()),
+					(int)arg.line_number);
+		}
+	}, result.value());
+}
+
+int SkaldContext::get_pending_commands() const {
+	return (int)queues_->commands.size();
+}
+
+int SkaldContext::get_pending_results() const {
+	return (int)queues_->results.size();
+}
+
+int SkaldContext::process(int p_max_commands) {
+	SkaldContextQueues &queues = *queues_;
+	int processed = 0;
+
+	while (p_max_commands <= 0 || processed < p_max_commands) {
+		// Leave commands queued rather than run one whose result has nowhere
+		// to go; the posting side drains results with poll().
+		if (queues.results.is_full()) {
+			break;
+		}
+		std::optional<SkaldCommand> command = queues.commands.pop();
+		if (!command.has_value()) {
+			break;
+		}
+
+		switch (command->type) {
+			case SkaldCommandType::SETUP:
+				queues.pending_path = command->text;
+				queues.pending_source = std::move(command->source);
+				queues.results.push(SkaldResult(std::in_place_type<Skald::ParseResult>,
+						engine_->setup(command->text)));
+				break;
+			case SkaldCommandType::LOAD:
+				queues.pending_path = command->text;
+				queues.pending_source = std::move(command->source);
+				queues.results.push(SkaldResult(std::in_place_type<Skald::ParseResult>,
+						engine_->load(command->text)));
+				break;
+			case SkaldCommandType::START:
+				queues.results.push(SkaldResult(std::in_place_type<Skald::Response>,
+						engine_->start()));
+				break;
+			case SkaldCommandType::START_AT:
+				queues.results.push(SkaldResult(std::in_place_type<Skald::Response>,
+						engine_->start_at(command->text)));
+				break;
+			case SkaldCommandType::ACT:
+				queues.results.push(SkaldResult(std::in_place_type<Skald::Response>,
+						engine_->act(command->index)));
+				break;
+			case SkaldCommandType::ANSWER:
+				queues.results.push(SkaldResult(std::in_place_type<Skald::Response>,
+						engine_->answer(Skald::QueryAnswer{ command->value })));
+				break;
+			case SkaldCommandType::SET_GLOBAL: {
+				// Successful sets produce no result, matching set_global()'s null.
+				if (!command->value.has_value()) {
+					queues.results.push(SkaldResult(std::in_place_type<SkaldTypeMismatch>));
+					break;
+				}
+				std::optional<Skald::Error> err = engine_->set(command->text, command->value.value());
+				if (err.has_value()) {
+					queues.results.push(SkaldResult(std::in_place_type<Skald::Error>,
+							std::move(err.value())));
+				}
+			} break;
+		}
+		queues.pending_source.reset();
+		processed++;
+	}
+	return processed;
+}
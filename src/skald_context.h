@@ -0,0 +1,51 @@
+#ifndef SKALD_CONTEXT_H
+#define SKALD_CONTEXT_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/variant.hpp>
+#include <memory>
+
+namespace Skald {
+class Engine;
+}
+
+struct SkaldContextQueues;
+
+// A Skald engine that can be driven from a worker thread. One thread (usually
+// the main thread) posts commands and polls for converted responses; another
+// calls process() to run them. Both queues are lock-free single-producer /
+// single-consumer rings, so each side must stay on one thread at a time.
+class SkaldContext : public godot::RefCounted {
+	GDCLASS(SkaldContext, godot::RefCounted)
+
+	// Only touched by the thread calling process().
+	std::unique_ptr<Skald::Engine> engine_;
+	std::unique_ptr<SkaldContextQueues> queues_;
+
+protected:
+	static void _bind_methods();
+
+public:
+	SkaldContext();
+	~SkaldContext();
+
+	// --- Posting thread ---
+
+	bool post_setup(const godot::String &p_path);
+	bool post_load(const godot::String &p_path);
+	bool post_start();
+	bool post_start_at(const godot::String &p_tag);
+	bool post_act(int p_choice_index = 0);
+	bool post_answer(const godot::Variant &p_value);
+	bool post_set_global(const godot::String &p_key, const godot::Variant &p_value);
+
+	godot::Variant poll();
+	int get_pending_commands() const;
+	int get_pending_results() const;
+
+	// --- Worker thread ---
+
+	int process(int p_max_commands = 0);
+};
+
+#endif // SKALD_CONTEXT_H
@@ -0,0 +1,195 @@
+#include "skald_convert.h"
+#include "skald_responses.h"
+
+using namespace godot;
+
+Variant rvalue_to_variant(const Skald::RValue &rv) {
+	if (auto *s = std::get_if<std::string>(&rv)) {
+		return String(s->c_str());
+	}
+	if (auto *b = std::get_if<bool>(&rv)) {
+		return *b;
+	}
+	if (auto *i = std::get_if<int>(&rv)) {
+		return *i;
+	}
+	if (auto *f = std::get_if<float>(&rv)) {
+		return (double)*f;
+	}
+	if (auto *v = std::get_if<Skald::Variable>(&rv)) {
+		return String(v->name.c_str());
+	}
+	if (auto *mc = std::get_if<std::shared_ptr<Skald::MethodCall>>(&rv)) {
+		return String((*mc)->dbg_desc().c_str());
+	}
+	return Variant();
+}
+
+Variant simple_rvalue_to_variant(const Skald::SimpleRValue &rv) {
+	if (auto *s = std::get_if<std::string>(&rv)) {
+		return String(s->c_str());
+	}
+	if (auto *b = std::get_if<bool>(&rv)) {
+		return *b;
+	}
+	if (auto *i = std::get_if<int>(&rv)) {
+		return *i;
+	}
+	if (auto *f = std::get_if<float>(&rv)) {
+		return (double)*f;
+	}
+	return Variant();
+}
+
+// Converts a Godot Variant to a Skald SimpleRValue. Returns nullopt for
+// unsupported types (anything but bool/int/float/String).
+std::optional<Skald::SimpleRValue> variant_to_simple_rvalue(const Variant &v) {
+	switch (v.get_type()) {
+		case Variant::BOOL:
+			return Skald::SimpleRValue{ (bool)v };
+		case Variant::INT:
+			return Skald::SimpleRValue{ static_cast<int>(static_cast<int64_t>(v)) };
+		case Variant::FLOAT:
+			return Skald::SimpleRValue{ static_cast<float>(static_cast<double>(v)) };
+		case Variant::STRING: {
+			String s = v;
+			return Skald::SimpleRValue{ std::string(s.utf8().get_data()) };
+		}
+		default:
+			return std::nullopt;
+	}
+}
+
+String chunks_to_string(const std::vector<Skald::Chunk> &chunks) {
+	std::string result;
+	for (const auto &chunk : chunks) {
+		result += chunk.text;
+	}
+	return String(result.c_str());
+}
+
+String SkaldLineCache::render(const std::string &p_text) {
+	auto it = lines_.find(p_text);
+	if (it != lines_.end()) {
+		return it->second;
+	}
+	if (lines_.size() >= MAX_LINES) {
+		lines_.clear();
+	}
+	String converted(p_text.c_str());
+	lines_.emplace(p_text, converted);
+	return converted;
+}
+
+// Like chunks_to_string, but single-chunk lines go through the cache (see
+// SkaldLineCache); copying a cached String only bumps its refcount. Lines of
+// several chunks are joined and converted every time.
+String render_chunks(const std::vector<Skald::Chunk> &chunks, SkaldLineCache *cache) {
+	if (!cache || chunks.size() != 1) {
+		return chunks_to_string(chunks);
+	}
+	return cache->render(chunks.front().text);
+}
+
+// Content, actions and notifications are passed with act(0); everything else
+// waits on the player or host (options, queries) or ends the run.
+bool is_advanceable(const Skald::Response &response) {
+	return std::holds_alternative<Skald::Content>(response) ||
+			std::holds_alternative<Skald::MethodCallPost>(response) ||
+			std::holds_alternative<Skald::Notification>(response);
+}
+
+Ref<SkaldError> make_error(int code, const String &message, int line_number) {
+	Ref<SkaldError> serr;
+	serr.instantiate();
+	serr->set_code(code);
+	serr->set_message(message);
+	serr->set_line_number(line_number);
+	return serr;
+}
+
+Ref<SkaldParseResult> make_parse_result(const Skald::ParseResult &pr) {
+	Ref<SkaldParseResult> spr;
+	spr.instantiate();
+	spr->set_ok(pr.ok);
+	for (const auto &ex : pr.exceptions) {
+		spr->add_error(String(ex.msg.c_str()), (int)ex.pos.line, (int)ex.pos.column,
+				String(ex.pos.source.c_str()), (int)ex.severity);
+	}
+	return spr;
+}
+
+// Dispatches directly on the 0.6 Response variant. get_response_type() is not
+// used: it collapses MethodCallPost / OptionGroup / Notification to UNKNOWN.
+// Text is rendered through the given line cache when one is passed.
+Variant convert_response(Skald::Response &response, SkaldLineCache *cache) {
+	return std::visit([cache](auto &&arg) -> Variant {
+		using T = std::decay_t<decltype(arg)>;
+
+		if constexpr (std::is_same_v<T, Skald::Content>) {
+			Ref<SkaldContent> sc;
+			sc.instantiate();
+			sc->set_attribution(String(arg.attribution.c_str()));
+			sc->set_text(render_chunks(arg.text, cache));
+			return sc;
+		} else if constexpr (std::is_same_v<T, Skald::OptionGroup>) {
+			Ref<SkaldOptionGroup> sg;
+			sg.instantiate();
+			for (const auto &option : arg.options) {
+				sg->add_option(render_chunks(option.text, cache), option.is_available);
+			}
+			return sg;
+		} else if constexpr (std::is_same_v<T, Skald::MethodCallGet>) {
+			Ref<SkaldQuery> sq;
+			sq.instantiate();
+			sq->set_method(String(arg.call.method.c_str()));
+			Array args;
+			for (const auto &a : arg.call.args) {
+				args.push_back(rvalue_to_variant(a));
+			}
+			sq->set_args(args);
+			return sq;
+		} else if constexpr (std::is_same_v<T, Skald::MethodCallPost>) {
+			Ref<SkaldAction> sa;
+			sa.instantiate();
+			sa->set_method(String(arg.call.method.c_str()));
+			Array args;
+			for (const auto &a : arg.call.args) {
+				args.push_back(rvalue_to_variant(a));
+			}
+			sa->set_args(args);
+			return sa;
+		} else if constexpr (std::is_same_v<T, Skald::Exit>) {
+			Ref<SkaldExit> se;
+			se.instantiate();
+			if (arg.argument.has_value()) {
+				se->set_value(rvalue_to_variant(arg.argument.value()));
+			}
+			return se;
+		} else if constexpr (std::is_same_v<T, Skald::GoModule>) {
+			Ref<SkaldGoModule> sg;
+			sg.instantiate();
+			sg->set_module_path(String(arg.module_path.c_str()));
+			sg->set_start_tag(String(arg.start_in_tag.c_str()));
+			return sg;
+		} else if constexpr (std::is_same_v<T, Skald::End>) {
+			Ref<SkaldEnd> se;
+			se.instantiate();
+			return se;
+		} else if constexpr (std::is_same_v<T, Skald::Error>) {
+			return make_error((int)arg.code, String(arg.message.c_str()),
+					(int)arg.line_number);
+		} else if constexpr (std::is_same_v<T, Skald::Notification>) {
+			Ref<SkaldNotification> sn;
+			sn.instantiate();
+			sn->set_var_name(String(arg.var_name.c_str()));
+			sn->set_scope(String(Skald::scope_to_str(arg.scope).c_str()));
+			if (arg.rval.has_value()) {
+				sn->set_value(simple_rvalue_to_variant(arg.rval.value()));
+			}
+			return sn;
+		} else {
+			return Variant();
+		}
+	}, response);
+}
@@ -0,0 +1,49 @@
+#ifndef SKALD_CONVERT_H
+#define SKALD_CONVERT_H
+
+#include "skald_responses.h"
+
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/variant.hpp>
+
+#include <skald.h>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Conversions between Skald core types and Godot Variants / response objects,
+// shared by SkaldEngine and SkaldContext.
+
+// Converted Strings for single-chunk lines, keyed by their UTF-8 text. This is
+// a plain bounded cache, not static-line detection: the core doesn't flag which
+// chunks are interpolated, so a line that is only an interpolation (e.g.
+// "{gold}") lands here once per distinct value. When full it is emptied rather
+// than pinned to whatever filled it. Every lookup still hashes the whole line;
+// a hit only saves the UTF-8 -> String transcode.
+class SkaldLineCache {
+	std::unordered_map<std::string, godot::String> lines_;
+
+public:
+	static const size_t MAX_LINES = 4096;
+
+	godot::String render(const std::string &p_text);
+	void clear() { lines_.clear(); }
+};
+
+godot::Variant rvalue_to_variant(const Skald::RValue &rv);
+godot::Variant simple_rvalue_to_variant(const Skald::SimpleRValue &rv);
+std::optional<Skald::SimpleRValue> variant_to_simple_rvalue(const godot::Variant &v);
+
+godot::String chunks_to_string(const std::vector<Skald::Chunk> &chunks);
+godot::String render_chunks(const std::vector<Skald::Chunk> &chunks, SkaldLineCache *cache);
+
+bool is_advanceable(const Skald::Response &response);
+
+godot::Ref<SkaldError> make_error(int code, const godot::String &message, int line_number);
+godot::Ref<SkaldParseResult> make_parse_result(const Skald::ParseResult &pr);
+godot::Variant convert_response(Skald::Response &response, SkaldLineCache *cache = nullptr);
+
+#endif // SKALD_CONVERT_H
@@ -1,4 +1,6 @@
 #include "skald_engine.h"
+#include "skald_convert.h"
+#include "skald_native.h"
 #include "skald_responses.h"
 
 #include <godot_cpp/classes/engine.hpp>
@@ -7,184 +9,299 @@
 
 #include <skald.h>
 
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 using namespace godot;
 
-// --- Helpers ---
+// --- Source reading ---
 
-static Variant rvalue_to_variant(const Skald::RValue &rv) {
-	if (auto *s = std::get_if<std::string>(&rv)) {
-		return String(s->c_str());
+// Reads through Godot's FileAccess so res:// URIs resolve in both editor and
+// exported (.pck) builds, where assets never exist on the OS filesystem.
+static std::optional<std::string> read_source(const std::string &p_resolved) {
+	Ref<FileAccess> f = FileAccess::open(String(p_resolved.c_str()), FileAccess::READ);
+	if (f.is_null()) {
+		return std::nullopt;
 	}
-	if (auto *b = std::get_if<bool>(&rv)) {
-		return *b;
+	return std::string(f->get_as_text().utf8().get_data());
+}
+
+// --- Manifest ---
+
+// Bounds on get_manifest()'s exploration. Hub menus loop back on themselves
+// and the core API has no way to tell a revisited block apart, so runs are
+// also cut off by step count. Every branch re-parses the module and replays
+// its inputs, so the number of branches is capped too.
+static const int MANIFEST_MAX_STEPS = 20000;
+static const int MANIFEST_MAX_BRANCH_STEPS = 1000;
+static const int MANIFEST_MAX_BRANCHES = 256;
+
+// One input given to a scratch engine: act(choice), or answer(value) to a query.
+struct ManifestStep {
+	bool is_answer = false;
+	int choice = 0;
+	bool value = false;
+};
+
+// Walks the branches reachable from the start of a module and collects what it
+// sees. Engines are never copied: each branch gets a fresh scratch engine that
+// replays the inputs leading to it, which relies on the core being
+// deterministic for a given codex, module and input sequence. This is a
+// best-effort dynamic walk at the codex's default globals, not a static
+// enumeration; anything it has to skip or guess at clears `complete`.
+struct ManifestBuilder {
+	std::string codex_path;
+	std::string module_path;
+
+	PackedStringArray attributions;
+	Array lines;
+	PackedStringArray methods;
+	Array go_targets;
+	bool complete = true;
+
+	std::unordered_set<std::string> seen_attributions;
+	std::unordered_set<std::string> seen_lines;
+	std::unordered_set<std::string> seen_methods;
+	std::unordered_set<std::string> seen_go_targets;
+	std::unordered_set<std::string> seen_menus;
+	int steps = 0;
+	SkaldLineCache line_cache;
+	// Files read so far, so replays don't hit FileAccess again.
+	std::unordered_map<std::string, std::optional<std::string>> sources;
+
+	// Returns a fresh engine with the codex and module loaded, storing the
+	// module's parse result in r_result.
+	std::unique_ptr<Skald::Engine> load_scratch(std::optional<Skald::ParseResult> &r_result) {
+		auto engine = std::make_unique<Skald::Engine>();
+		engine->set_source_reader(
+				[this](const std::string &resolved) -> std::optional<std::string> {
+					auto it = sources.find(resolved);
+					if (it == sources.end()) {
+						it = sources.emplace(resolved, read_source(resolved)).first;
+					}
+					return it->second;
+				});
+		if (!codex_path.empty()) {
+			engine->setup(codex_path);
+		}
+		r_result = engine->load(module_path);
+		return engine;
 	}
-	if (auto *i = std::get_if<int>(&rv)) {
-		return *i;
+
+	void add_method(const std::string &method) {
+		if (seen_methods.insert(method).second) {
+			methods.push_back(String(method.c_str()));
+		}
 	}
-	if (auto *f = std::get_if<float>(&rv)) {
-		return (double)*f;
+
+	void record(const Skald::Response &response) {
+		if (auto *content = std::get_if<Skald::Content>(&response)) {
+			if (!content->attribution.empty() &&
+					seen_attributions.insert(content->attribution).second) {
+				attributions.push_back(String(content->attribution.c_str()));
+			}
+			String text = render_chunks(content->text, &line_cache);
+			if (seen_lines.insert(content->attribution + "\n" + text.utf8().get_data()).second) {
+				Dictionary line;
+				line["attribution"] = String(content->attribution.c_str());
+				line["text"] = text;
+				line["index"] = lines.size();
+				lines.push_back(line);
+			}
+		} else if (auto *get = std::get_if<Skald::MethodCallGet>(&response)) {
+			add_method(get->call.method);
+		} else if (auto *post = std::get_if<Skald::MethodCallPost>(&response)) {
+			add_method(post->call.method);
+		} else if (auto *go = std::get_if<Skald::GoModule>(&response)) {
+			if (seen_go_targets.insert(go->module_path + "#" + go->start_in_tag).second) {
+				Dictionary target;
+				target["module_path"] = String(go->module_path.c_str());
+				target["start_tag"] = String(go->start_in_tag.c_str());
+				go_targets.push_back(target);
+			}
+		}
 	}
-	if (auto *v = std::get_if<Skald::Variable>(&rv)) {
-		return String(v->name.c_str());
+
+	static Skald::Response apply(Skald::Engine &engine, const ManifestStep &step) {
+		if (step.is_answer) {
+			return engine.answer(Skald::QueryAnswer{ Skald::SimpleRValue{ step.value } });
+		}
+		return engine.act(step.choice);
 	}
-	if (auto *mc = std::get_if<std::shared_ptr<Skald::MethodCall>>(&rv)) {
-		return String((*mc)->dbg_desc().c_str());
+
+	// Takes p_step on the current branch and remembers it in path.
+	static Skald::Response advance(Skald::Engine &engine, std::vector<ManifestStep> &path,
+			const ManifestStep &p_step) {
+		path.push_back(p_step);
+		return apply(engine, p_step);
 	}
-	return Variant();
-}
 
-static Variant simple_rvalue_to_variant(const Skald::SimpleRValue &rv) {
-	if (auto *s = std::get_if<std::string>(&rv)) {
-		return String(s->c_str());
+	// p_root is the engine get_manifest() already loaded; it walks the first
+	// branch so the module isn't parsed twice for it.
+	void explore(std::unique_ptr<Skald::Engine> p_root) {
+		// Input sequences (from start()) that reach branches still to walk.
+		std::vector<std::vector<ManifestStep>> pending;
+		pending.emplace_back();
+		int branches = 0;
+
+		while (!pending.empty()) {
+			if (branches >= MANIFEST_MAX_BRANCHES) {
+				complete = false;
+				return;
+			}
+			branches++;
+			std::vector<ManifestStep> path = std::move(pending.back());
+			pending.pop_back();
+
+			std::unique_ptr<Skald::Engine> engine = std::move(p_root);
+			if (!engine) {
+				std::optional<Skald::ParseResult> result;
+				engine = load_scratch(result);
+				if (!result->ok) {
+					complete = false;
+					continue;
+				}
+			}
+			// What the replayed steps produce was recorded on the branch that
+			// queued this one.
+			Skald::Response response = engine->start();
+			for (const ManifestStep &step : path) {
+				response = apply(*engine, step);
+			}
+
+			for (int branch_steps = 0;; branch_steps++) {
+				if (steps >= MANIFEST_MAX_STEPS) {
+					complete = false;
+					return;
+				}
+				if (branch_steps >= MANIFEST_MAX_BRANCH_STEPS) {
+					complete = false;
+					break;
+				}
+				steps++;
+				record(response);
+
+				if (is_advanceable(response)) {
+					response = advance(*engine, path, ManifestStep{});
+				} else if (auto *group = std::get_if<Skald::OptionGroup>(&response)) {
+					// Menus are matched by their labels, since the core API
+					// doesn't say which block a menu came from. That stops
+					// looping hubs, but a different menu with the same labels
+					// is skipped too, so the result can't claim completeness.
+					std::string signature;
+					std::vector<int> available;
+					for (int i = 0; i < (int)group->options.size(); i++) {
+						const auto &option = group->options[i];
+						for (const auto &chunk : option.text) {
+							signature += chunk.text;
+						}
+						signature += option.is_available ? "\n1" : "\n0";
+						if (option.is_available) {
+							available.push_back(i);
+						} else {
+							// Gated on a condition that is false at the
+							// default globals; what lies behind it is unseen.
+							complete = false;
+						}
+					}
+					if (available.empty()) {
+						break;
+					}
+					if (!seen_menus.insert(signature).second) {
+						complete = false;
+						break;
+					}
+					for (size_t i = 1; i < available.size(); i++) {
+						pending.push_back(path);
+						pending.back().push_back(ManifestStep{ false, available[i], false });
+					}
+					response = advance(*engine, path, ManifestStep{ false, available[0], false });
+				} else if (std::holds_alternative<Skald::MethodCallGet>(response)) {
+					// Host answers are unknown ahead of time. Both sides of a
+					// boolean gate are followed; branches on int or string
+					// answers are never reached.
+					complete = false;
+					pending.push_back(path);
+					pending.back().push_back(ManifestStep{ true, 0, false });
+					response = advance(*engine, path, ManifestStep{ true, 0, true });
+				} else {
+					// GO, exit, end and errors all finish the branch.
+					break;
+				}
+			}
+		}
 	}
-	if (auto *b = std::get_if<bool>(&rv)) {
-		return *b;
+};
+
+// --- SkaldEngineNative ---
+
+// The native interface shares the node's engine. It skips response conversion
+// entirely, so after a native step get_current() returns null. Results live in
+// the members below until the next call, so they're always allocated and freed
+// on this side of the module boundary.
+class SkaldEngineNative final : public SkaldNativeInterface {
+	SkaldEngine &owner_;
+
+	// Optional only so the core types needn't be default-constructible; each
+	// is set before its first reference is handed out.
+	std::optional<Skald::ParseResult> parse_result_;
+	std::optional<Skald::Response> response_;
+	std::optional<Skald::Error> set_error_;
+	std::optional<std::variant<Skald::Error, Skald::SimpleRValue>> global_;
+
+	const Skald::Response &record(Skald::Response p_response) {
+		response_ = std::move(p_response);
+		owner_.current_response_ = Variant();
+		return *response_;
 	}
-	if (auto *i = std::get_if<int>(&rv)) {
-		return *i;
+
+public:
+	explicit SkaldEngineNative(SkaldEngine &p_owner) : owner_(p_owner) {}
+	~SkaldEngineNative() override = default;
+
+	const Skald::ParseResult &load(const std::string &p_path) override {
+		parse_result_ = owner_.engine_->load(p_path);
+		return *parse_result_;
 	}
-	if (auto *f = std::get_if<float>(&rv)) {
-		return (double)*f;
+
+	const Skald::Response &start() override {
+		return record(owner_.engine_->start());
 	}
-	return Variant();
-}
 
-// Converts a Godot Variant to a Skald SimpleRValue. Returns nullopt for
-// unsupported types (anything but bool/int/float/String).
-static std::optional<Skald::SimpleRValue> variant_to_simple_rvalue(const Variant &v) {
-	switch (v.get_type()) {
-		case Variant::BOOL:
-			return Skald::SimpleRValue{ (bool)v };
-		case Variant::INT:
-			return Skald::SimpleRValue{ static_cast<int>(static_cast<int64_t>(v)) };
-		case Variant::FLOAT:
-			return Skald::SimpleRValue{ static_cast<float>(static_cast<double>(v)) };
-		case Variant::STRING: {
-			String s = v;
-			return Skald::SimpleRValue{ std::string(s.utf8().get_data()) };
-		}
-		default:
-			return std::nullopt;
+	const Skald::Response &start_at(const std::string &p_tag) override {
+		return record(owner_.engine_->start_at(p_tag));
 	}
-}
 
-static String chunks_to_string(const std::vector<Skald::Chunk> &chunks) {
-	std::string result;
-	for (const auto &chunk : chunks) {
-		result += chunk.text;
+	const Skald::Response &act(int p_choice_index) override {
+		return record(owner_.engine_->act(p_choice_index));
 	}
-	return String(result.c_str());
-}
 
-static Ref<SkaldError> make_error(int code, const String &message, int line_number) {
-	Ref<SkaldError> serr;
-	serr.instantiate();
-	serr->set_code(code);
-	serr->set_message(message);
-	serr->set_line_number(line_number);
-	return serr;
-}
+	const Skald::Response &answer(const std::optional<Skald::SimpleRValue> &p_value) override {
+		return record(owner_.engine_->answer(Skald::QueryAnswer{ p_value }));
+	}
 
-static Ref<SkaldParseResult> make_parse_result(const Skald::ParseResult &pr) {
-	Ref<SkaldParseResult> spr;
-	spr.instantiate();
-	spr->set_ok(pr.ok);
-	for (const auto &ex : pr.exceptions) {
-		spr->add_error(String(ex.msg.c_str()), (int)ex.pos.line, (int)ex.pos.column,
-				String(ex.pos.source.c_str()), (int)ex.severity);
+	const std::optional<Skald::Error> &set_global(const std::string &p_key,
+			const Skald::SimpleRValue &p_value) override {
+		set_error_ = owner_.engine_->set(p_key, p_value);
+		return set_error_;
 	}
-	return spr;
-}
 
-// Dispatches directly on the 0.6 Response variant. get_response_type() is not
-// used: it collapses MethodCallPost / OptionGroup / Notification to UNKNOWN.
-static Variant convert_response(Skald::Response &response) {
-	return std::visit([](auto &&arg) -> Variant {
-		using T = std::decay_t<decltype(arg)>;
-
-		if constexpr (std::is_same_v<T, Skald::Content>) {
-			Ref<SkaldContent> sc;
-			sc.instantiate();
-			sc->set_attribution(String(arg.attribution.c_str()));
-			sc->set_text(chunks_to_string(arg.text));
-			return sc;
-		} else if constexpr (std::is_same_v<T, Skald::OptionGroup>) {
-			Ref<SkaldOptionGroup> sg;
-			sg.instantiate();
-			for (const auto &option : arg.options) {
-				sg->add_option(chunks_to_string(option.text), option.is_available);
-			}
-			return sg;
-		} else if constexpr (std::is_same_v<T, Skald::MethodCallGet>) {
-			Ref<SkaldQuery> sq;
-			sq.instantiate();
-			sq->set_method(String(arg.call.method.c_str()));
-			Array args;
-			for (const auto &a : arg.call.args) {
-				args.push_back(rvalue_to_variant(a));
-			}
-			sq->set_args(args);
-			return sq;
-		} else if constexpr (std::is_same_v<T, Skald::MethodCallPost>) {
-			Ref<SkaldAction> sa;
-			sa.instantiate();
-			sa->set_method(String(arg.call.method.c_str()));
-			Array args;
-			for (const auto &a : arg.call.args) {
-				args.push_back(rvalue_to_variant(a));
-			}
-			sa->set_args(args);
-			return sa;
-		} else if constexpr (std::is_same_v<T, Skald::Exit>) {
-			Ref<SkaldExit> se;
-			se.instantiate();
-			if (arg.argument.has_value()) {
-				se->set_value(rvalue_to_variant(arg.argument.value()));
-			}
-			return se;
-		} else if constexpr (std::is_same_v<T, Skald::GoModule>) {
-			Ref<SkaldGoModule> sg;
-			sg.instantiate();
-			sg->set_module_path(String(arg.module_path.c_str()));
-			sg->set_start_tag(String(arg.start_in_tag.c_str()));
-			return sg;
-		} else if constexpr (std::is_same_v<T, Skald::End>) {
-			Ref<SkaldEnd> se;
-			se.instantiate();
-			return se;
-		} else if constexpr (std::is_same_v<T, Skald::Error>) {
-			return make_error((int)arg.code, String(arg.message.c_str()),
-					(int)arg.line_number);
-		} else if constexpr (std::is_same_v<T, Skald::Notification>) {
-			Ref<SkaldNotification> sn;
-			sn.instantiate();
-			sn->set_var_name(String(arg.var_name.c_str()));
-			sn->set_scope(String(Skald::scope_to_str(arg.scope).c_str()));
-			if (arg.rval.has_value()) {
-				sn->set_value(simple_rvalue_to_variant(arg.rval.value()));
-			}
-			return sn;
-		} else {
-			return Variant();
-		}
-	}, response);
-}
+	const std::variant<Skald::Error, Skald::SimpleRValue> &get_global(const std::string &p_key) override {
+		global_ = owner_.engine_->get(p_key);
+		return *global_;
+	}
+};
 
 // --- SkaldEngine ---
 
-SkaldEngine::SkaldEngine() : engine_(std::make_unique<Skald::Engine>()) {
+SkaldEngine::SkaldEngine() :
+		engine_(std::make_unique<Skald::Engine>()),
+		native_(std::make_unique<SkaldEngineNative>(*this)) {
 	// Route all source reads (initial codex + every GO transition) through
-	// Godot's FileAccess so res:// URIs resolve in both editor and exported
-	// (.pck) builds, where assets never exist on the OS filesystem.
-	engine_->set_source_reader(
-			[](const std::string &resolved) -> std::optional<std::string> {
-				String gpath = String(resolved.c_str());
-				Ref<FileAccess> f = FileAccess::open(gpath, FileAccess::READ);
-				if (f.is_null()) {
-					return std::nullopt;
-				}
-				return std::string(f->get_as_text().utf8().get_data());
-			});
+	// read_source() above.
+	engine_->set_source_reader(read_source);
 }
 SkaldEngine::~SkaldEngine() = default;
 
@@ -199,6 +316,7 @@ void SkaldEngine::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("answer", "value"), &SkaldEngine::answer);
 	ClassDB::bind_method(D_METHOD("set_global", "key", "value"), &SkaldEngine::set_global);
 	ClassDB::bind_method(D_METHOD("get_global", "key"), &SkaldEngine::get_global);
+	ClassDB::bind_method(D_METHOD("get_manifest", "path"), &SkaldEngine::get_manifest);
 
 	ClassDB::bind_method(D_METHOD("set_codex_path", "path"), &SkaldEngine::set_codex_path);
 	ClassDB::bind_method(D_METHOD("get_codex_path"), &SkaldEngine::get_codex_path);
@@ -227,30 +345,30 @@ String SkaldEngine::get_codex_path() const {
 }
 
 Variant SkaldEngine::setup(const String &p_path) {
-	Skald::ParseResult result = engine_->setup(std::string(p_path.utf8().get_data()));
+	setup_path_ = p_path.utf8().get_data();
+	Skald::ParseResult result = engine_->setup(setup_path_);
 	return make_parse_result(result);
 }
 
 Variant SkaldEngine::load(const String &p_path) {
-	Skald::ParseResult result = engine_->load(std::string(p_path.utf8().get_data()));
-	return make_parse_result(result);
+	return make_parse_result(native_->load(std::string(p_path.utf8().get_data())));
 }
 
 Variant SkaldEngine::start() {
 	Skald::Response response = engine_->start();
-	current_response_ = convert_response(response);
+	current_response_ = convert_response(response, &line_cache_);
 	return current_response_;
 }
 
 Variant SkaldEngine::start_at(const String &p_tag) {
 	Skald::Response response = engine_->start_at(std::string(p_tag.utf8().get_data()));
-	current_response_ = convert_response(response);
+	current_response_ = convert_response(response, &line_cache_);
 	return current_response_;
 }
 
 Variant SkaldEngine::act(int p_choice_index) {
 	Skald::Response response = engine_->act(p_choice_index);
-	current_response_ = convert_response(response);
+	current_response_ = convert_response(response, &line_cache_);
 	return current_response_;
 }
 
@@ -273,7 +391,7 @@ Variant SkaldEngine::answer(const Variant &p_value) {
 	}
 
 	Skald::Response response = engine_->answer(qa);
-	current_response_ = convert_response(response);
+	current_response_ = convert_response(response, &line_cache_);
 	return current_response_;
 }
 
@@ -302,3 +420,44 @@ Variant SkaldEngine::get_global(const String &p_key) {
 	}
 	return simple_rvalue_to_variant(std::get<Skald::SimpleRValue>(result));
 }
+
+Dictionary SkaldEngine::get_manifest(const String &p_path) {
+	Dictionary manifest;
+
+	// Explore on scratch engines so the live run is untouched.
+	ManifestBuilder builder;
+	builder.codex_path = setup_path_;
+	builder.module_path = p_path.utf8().get_data();
+	std::optional<Skald::ParseResult> result;
+	std::unique_ptr<Skald::Engine> scratch = builder.load_scratch(result);
+
+	manifest["ok"] = result->ok;
+	if (!result->ok) {
+		manifest["errors"] = make_parse_result(*result)->get_errors();
+		return manifest;
+	}
+
+	builder.explore(std::move(scratch));
+
+	manifest["attributions"] = builder.attributions;
+	manifest["lines"] = builder.lines;
+	manifest["methods"] = builder.methods;
+	manifest["go_targets"] = builder.go_targets;
+	manifest["complete"] = builder.complete;
+	return manifest;
+}
+
+SkaldNativeInterface *SkaldEngine::get_native_interface() {
+	return native_.get();
+}
+
+// Native entry point looked up by skald_get_native_interface(). Deliberately
+// not bound in ClassDB, so scripts never see the raw pointer.
+extern "C" GDE_EXPORT SkaldNativeInterface *skald_godot_get_native_interface(
+		GDExtensionObjectPtr p_engine, uint32_t p_api_version) {
+	if (p_engine == nullptr || p_api_version != SKALD_NATIVE_API_VERSION) {
+		return nullptr;
+	}
+	SkaldEngine *engine = Object::cast_to<SkaldEngine>(internal::get_object_instance_binding(p_engine));
+	return engine ? engine->get_native_interface() : nullptr;
+}
@@ -1,21 +1,40 @@
 #ifndef SKALD_ENGINE_H
 #define SKALD_ENGINE_H
 
+#include "skald_convert.h"
+
 #include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
 #include <godot_cpp/variant/variant.hpp>
 #include <memory>
+#include <optional>
+#include <string>
 
 namespace Skald {
 class Engine;
 }
 
+class SkaldEngineNative;
+class SkaldNativeInterface;
+
 class SkaldEngine : public godot::Node {
 	GDCLASS(SkaldEngine, godot::Node)
 
+	friend class SkaldEngineNative;
+
 	std::unique_ptr<Skald::Engine> engine_;
+	// Unboxed view of this engine handed out by get_native_interface().
+	std::unique_ptr<SkaldEngineNative> native_;
 	godot::Variant current_response_;
 	godot::String codex_path_;
 
+	// Converted text of recently shown single-chunk lines (see SkaldLineCache).
+	SkaldLineCache line_cache_;
+
+	// Codex passed to setup(), replayed into scratch engines by get_manifest().
+	std::string setup_path_;
+
 protected:
 	static void _bind_methods();
 
@@ -39,6 +58,11 @@ public:
 
 	godot::Variant set_global(const godot::String &p_key, const godot::Variant &p_value);
 	godot::Variant get_global(const godot::String &p_key);
+
+	godot::Dictionary get_manifest(const godot::String &p_path);
+
+	// Not bound; reached from other GDExtensions through skald_native.h.
+	SkaldNativeInterface *get_native_interface();
 };
 
 #endif // SKALD_ENGINE_H
@@ -0,0 +1,154 @@
+#ifndef SKALD_NATIVE_H
+#define SKALD_NATIVE_H
+
+// Native interface to a SkaldEngine node for other GDExtensions.
+//
+// The bound SkaldEngine methods box every response into RefCounted objects and
+// every path into a Godot String. Native callers can instead fetch this
+// interface once and step the engine with plain Skald types:
+//
+//     SkaldNativeInterface *skald = skald_get_native_interface(engine_node);
+//     if (skald) {
+//         const Skald::Response &response = skald->start();
+//         ...
+//     }
+//
+// Ownership stays on the skald-godot side. Results are returned by const
+// reference to storage the interface owns, valid until the next call on the
+// same interface; callers read them (or copy them into their own types) and
+// never free or modify them. Arguments are only read for the duration of the
+// call. The interface itself belongs to the node and can't be deleted.
+//
+// The interface still passes std:: and Skald:: types across the module
+// boundary, so the calling GDExtension must be built with the same compiler,
+// C++ standard library and runtime as skald-godot, against the same skald
+// submodule revision. On Windows both must use the shared CRT (/MD); with a
+// statically linked CRT (/MT) each module has its own heap, and copying a
+// returned object in the caller allocates from a different heap than the one
+// that owns it.
+//
+// The interface isn't bound in ClassDB, so scripts can't reach it. The
+// skald-godot library exports a C entry point (SKALD_NATIVE_ENTRY) instead;
+// skald_get_native_interface() finds the loaded library by name, looks the
+// entry point up and passes it the engine object.
+//
+// Release builds ship this header in addons/skald/include/, next to the pinned
+// skald core headers it includes; put that directory on the include path.
+// Bump SKALD_NATIVE_API_VERSION whenever the interface below changes; a
+// mismatched caller gets nullptr rather than a bad vtable.
+
+#include <godot_cpp/classes/object.hpp>
+
+#include <skald.h>
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <variant>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <dlfcn.h>
+#include <mach-o/dyld.h>
+#else
+#include <dlfcn.h>
+#include <link.h>
+#endif
+
+#define SKALD_NATIVE_API_VERSION 3
+
+// File name prefix of the skald-godot library (see SConstruct).
+#define SKALD_NATIVE_LIBRARY "libskald_godot"
+// Exported by that library; see SkaldNativeEntry.
+#define SKALD_NATIVE_ENTRY "skald_godot_get_native_interface"
+
+class SkaldNativeInterface {
+protected:
+	virtual ~SkaldNativeInterface() = default;
+
+public:
+	virtual const Skald::ParseResult &load(const std::string &p_path) = 0;
+	virtual const Skald::Response &start() = 0;
+	virtual const Skald::Response &start_at(const std::string &p_tag) = 0;
+	virtual const Skald::Response &act(int p_choice_index = 0) = 0;
+	virtual const Skald::Response &answer(const std::optional<Skald::SimpleRValue> &p_value) = 0;
+
+	virtual const std::optional<Skald::Error> &set_global(const std::string &p_key,
+			const Skald::SimpleRValue &p_value) = 0;
+	virtual const std::variant<Skald::Error, Skald::SimpleRValue> &get_global(const std::string &p_key) = 0;
+};
+
+// Takes the engine's Godot object and the caller's SKALD_NATIVE_API_VERSION.
+// Returns nullptr if the object isn't a SkaldEngine or the versions differ.
+typedef SkaldNativeInterface *(*SkaldNativeEntry)(GDExtensionObjectPtr p_engine, uint32_t p_api_version);
+
+// Looks SKALD_NATIVE_ENTRY up in the loaded skald-godot library, or returns
+// nullptr if it isn't loaded. Godot loads extensions with local symbol
+// visibility, so the library is found by file name among the loaded modules.
+inline SkaldNativeEntry skald_find_native_entry() {
+#if defined(_WIN32)
+	HMODULE modules[1024];
+	DWORD needed = 0;
+	if (!K32EnumProcessModules(GetCurrentProcess(), modules, sizeof(modules), &needed)) {
+		return nullptr;
+	}
+	for (DWORD i = 0; i < needed / sizeof(HMODULE) && i < 1024; i++) {
+		char name[MAX_PATH];
+		if (GetModuleFileNameA(modules[i], name, MAX_PATH) && std::strstr(name, SKALD_NATIVE_LIBRARY)) {
+			return reinterpret_cast<SkaldNativeEntry>(GetProcAddress(modules[i], SKALD_NATIVE_ENTRY));
+		}
+	}
+	return nullptr;
+#else
+	const char *path = nullptr;
+#if defined(__APPLE__)
+	for (uint32_t i = 0; i < _dyld_image_count() && !path; i++) {
+		const char *name = _dyld_get_image_name(i);
+		if (name && std::strstr(name, SKALD_NATIVE_LIBRARY)) {
+			path = name;
+		}
+	}
+#else
+	dl_iterate_phdr([](struct dl_phdr_info *p_info, size_t, void *p_path) -> int {
+		if (p_info->dlpi_name && std::strstr(p_info->dlpi_name, SKALD_NATIVE_LIBRARY)) {
+			*static_cast<const char **>(p_path) = p_info->dlpi_name;
+			return 1;
+		}
+		return 0;
+	},
+			&path);
+#endif
+	if (!path) {
+		return nullptr;
+	}
+	// RTLD_NOLOAD only takes another reference to the copy Godot loaded;
+	// dropping it again leaves that copy (and the entry point) in place.
+	void *handle = dlopen(path, RTLD_NOW | RTLD_NOLOAD);
+	if (!handle) {
+		return nullptr;
+	}
+	SkaldNativeEntry entry = reinterpret_cast<SkaldNativeEntry>(dlsym(handle, SKALD_NATIVE_ENTRY));
+	dlclose(handle);
+	return entry;
+#endif
+}
+
+// Returns the native interface of a SkaldEngine node, or nullptr if p_engine
+// isn't one, skald-godot isn't loaded, or it was built with a different
+// SKALD_NATIVE_API_VERSION. The pointer stays valid for the lifetime of the
+// node.
+inline SkaldNativeInterface *skald_get_native_interface(godot::Object *p_engine) {
+	static SkaldNativeEntry entry = skald_find_native_entry();
+	if (p_engine == nullptr || entry == nullptr) {
+		return nullptr;
+	}
+	return entry(p_engine->_owner, SKALD_NATIVE_API_VERSION);
+}
+
+#endif // SKALD_NATIVE_H
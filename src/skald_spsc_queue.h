@@ -0,0 +1,57 @@
+#ifndef SKALD_SPSC_QUEUE_H
+#define SKALD_SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+// Fixed-capacity lock-free ring buffer for exactly one producer thread and one
+// consumer thread. push() may only be called from the producer and pop() only
+// from the consumer; size() and the full/empty checks are safe from either,
+// but are only a snapshot. Holds up to N - 1 items.
+template <typename T, size_t N>
+class SkaldSpscQueue {
+	static_assert(N >= 2, "SkaldSpscQueue needs room for at least one item");
+
+	std::array<std::optional<T>, N> slots_;
+	// Next slot to pop; written by the consumer only.
+	alignas(64) std::atomic<size_t> head_{ 0 };
+	// Next slot to push; written by the producer only.
+	alignas(64) std::atomic<size_t> tail_{ 0 };
+
+public:
+	bool push(T &&p_item) {
+		size_t tail = tail_.load(std::memory_order_relaxed);
+		size_t next = (tail + 1) % N;
+		if (next == head_.load(std::memory_order_acquire)) {
+			return false;
+		}
+		slots_[tail].emplace(std::move(p_item));
+		tail_.store(next, std::memory_order_release);
+		return true;
+	}
+
+	std::optional<T> pop() {
+		size_t head = head_.load(std::memory_order_relaxed);
+		if (head == tail_.load(std::memory_order_acquire)) {
+			return std::nullopt;
+		}
+		std::optional<T> item = std::move(slots_[head]);
+		slots_[head].reset();
+		head_.store((head + 1) % N, std::memory_order_release);
+		return item;
+	}
+
+	size_t size() const {
+		size_t head = head_.load(std::memory_order_acquire);
+		size_t tail = tail_.load(std::memory_order_acquire);
+		return (tail + N - head) % N;
+	}
+
+	bool is_empty() const { return size() == 0; }
+	bool is_full() const { return size() == N - 1; }
+};
+
+#endif // SKALD_SPSC_QUEUE_H